@@ -2,4 +2,6 @@
 #SBATCH --partition=cbuild 
 module load 2022 
 module load GCCcore/11.3.0 
-gcc -fopenmp -o pi pi.c -lm
\ No newline at end of file
+gcc -fopenmp -o pi pi.c -lm
+# Vectorized build for PI_METHOD=montecarlo, targeting the Zen 2 CPUs of the rome partition
+gcc -O3 -march=znver2 -fopenmp -o pi_mc pi.c -lm
\ No newline at end of file
@@ -1,3 +1,5 @@
+import csv
+import sys
 import matplotlib.pyplot as plt
 
 threads = [8,12,16,20,24,28,32,36,40,44,48]
@@ -14,9 +16,24 @@ times = [
     0.685874,
     0.744235  
     ]
+errors = None
+
+# A CSV written by "PI_TUNE=1 ./pi" replaces the numbers above,
+# keeping the fastest configuration for every number of threads
+if len(sys.argv) > 1:
+    best = {}
+    with open(sys.argv[1]) as f:
+        for row in csv.DictReader(f):
+            cpus, latency = int(row['CPUs']), float(row['latency'])
+            ci = float(row.get('ci95') or 0)
+            if cpus not in best or latency < best[cpus][0]:
+                best[cpus] = (latency, ci)
+    threads = sorted(best)
+    times = [best[t][0] for t in threads]
+    errors = [best[t][1] for t in threads]
 
 plt.figure(figsize=(10, 6))
-plt.plot(threads, times, marker='o', linestyle='-', color='b')
+plt.errorbar(threads, times, yerr=errors, marker='o', linestyle='-', color='b', capsize=3)
 plt.title('Execution Time of Pi Computation vs Number of Threads')
 plt.xlabel('Number of Threads')
 plt.ylabel('Execution Time (seconds)')
@@ -3,7 +3,7 @@
 #SBATCH --nodes=1
 #SBATCH --ntasks=1 
 #SBATCH --cpus-per-task=32
-#SBATCH --time=00:10:00 
+#SBATCH --time=00:30:00 
 #SBATCH --partition=rome 
 #SBATCH --output=pi_%j.out 
 #SBATCH --error=pi_%j.err 
@@ -12,11 +12,11 @@ module load 2022
 module load GCCcore/11.3.0 
 echo "OpenMP parallelism" 
 echo 
-for ncores in `seq 8 4 48` 
-do 
-export OMP_NUM_THREADS=$ncores 
-echo "CPUS: " $OMP_NUM_THREADS 
-echo "CPUS: " $OMP_NUM_THREADS >&2 
+# The sweep over threads, schedules and binding runs inside ./pi,
+# the fastest configuration is cached in pi_tune_<host>.cfg and only
+# reused by runs with the same OMP_PLACES, rerun with each value to sweep it
+export PI_TUNE=1 
+export TUNE_THREADS=`seq -s, 8 4 48` 
+export TUNE_CSV=pi_tune.csv 
 ./pi 
-echo "DONE " 
-done
\ No newline at end of file
+echo "DONE "
\ No newline at end of file
@@ -1,30 +1,452 @@
+#include <errno.h>
 #include <omp.h>
 #include <math.h>
+#include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+// Philox4x32-10 constants (Salmon et al., "Parallel random numbers: as easy as 1, 2, 3")
+#define PHILOX_M0 0xD2511F53u
+#define PHILOX_M1 0xCD9E8D57u
+#define PHILOX_W0 0x9E3779B9u
+#define PHILOX_W1 0xBB67AE85u
+#define PHILOX_ROUNDS 10
+
+// A point (x, y) with 31 bit coordinates is inside the circle iff x^2 + y^2 < 2^62
+#define CIRCLE_RADIUS_SQ (1ull << 62)
+
+// Thread binding policies swept by the autotuner, "default" leaves OMP_PROC_BIND in charge
+enum { BIND_DEFAULT, BIND_CLOSE, BIND_SPREAD, NUM_BINDS };
+static const char *bind_names[NUM_BINDS] = {"default", "close", "spread"};
+
+// Two sided 95% quantiles of Student's t distribution for 1..30 degrees of freedom
+static const double t_quantiles[30] = {
+    12.706, 4.303, 3.182, 2.776, 2.571, 2.447, 2.365, 2.306, 2.262, 2.228,
+    2.201, 2.179, 2.160, 2.145, 2.131, 2.120, 2.110, 2.101, 2.093, 2.086,
+    2.080, 2.074, 2.069, 2.064, 2.060, 2.056, 2.052, 2.048, 2.045, 2.042
+};
+
+#define MAX_TUNE_THREADS 256
+#define MAX_TUNE_TRIALS 100
+
+/**
+ * An OpenMP configuration of the Leibniz loop.
+ */
+typedef struct {
+    int threads;
+    omp_sched_t kind;
+    int chunk;
+    int bind;
+} config_t;
+
+/**
+ * Counts how many of the two points drawn from one Philox4x32-10 block fall inside
+ * the unit quarter circle. The block is a pure function of (counter, seed), so every
+ * thread and SIMD lane draws an independent, reproducible stream with no shared state.
+ *
+ * @param counter Index of the pair of points, points 2*counter and 2*counter+1.
+ * @param seed Key of the generator.
+ * @return Number of points inside the circle (0, 1 or 2).
+ */
+#pragma omp declare simd uniform(seed) notinbranch
+static inline int philox_pair_hits(uint64_t counter, uint64_t seed) {
+    uint32_t c0 = (uint32_t)counter, c1 = (uint32_t)(counter >> 32), c2 = 0, c3 = 0;
+    uint32_t k0 = (uint32_t)seed, k1 = (uint32_t)(seed >> 32);
+    for (int r = 0; r < PHILOX_ROUNDS; r++) {
+        uint64_t p0 = (uint64_t)PHILOX_M0 * c0;
+        uint64_t p1 = (uint64_t)PHILOX_M1 * c2;
+        c0 = (uint32_t)(p1 >> 32) ^ c1 ^ k0;
+        c1 = (uint32_t)p1;
+        c2 = (uint32_t)(p0 >> 32) ^ c3 ^ k1;
+        c3 = (uint32_t)p0;
+        k0 += PHILOX_W0;
+        k1 += PHILOX_W1;
+    }
+    // Keep 31 bits per coordinate so the squared distance fits in 64 bits exactly
+    uint64_t x0 = c0 >> 1, y0 = c1 >> 1, x1 = c2 >> 1, y1 = c3 >> 1;
+    return (x0 * x0 + y0 * y0 < CIRCLE_RADIUS_SQ) + (x1 * x1 + y1 * y1 < CIRCLE_RADIUS_SQ);
+}
+
+/**
+ * Estimates pi by Monte Carlo sampling of the unit quarter circle.
+ * The hit count is an exact integer reduction, so the output is identical
+ * for the same seed at any thread count. Only the optimized pi_mc build of
+ * compile_job.sh vectorizes the loop.
+ *
+ * @param npairs Number of pairs of points to draw.
+ * @param seed Seed of the generator.
+ * @return Number of points inside the circle.
+ */
+long long monte_carlo_hits(long long npairs, uint64_t seed) {
+    long long hits = 0;
+
+    /* Fork a team of threads, each one drawing whole SIMD vectors of pairs */
+    #pragma omp parallel for simd reduction(+ : hits) schedule(simd : static)
+    for (long long i = 0; i < npairs; i++) {
+        hits += philox_pair_hits((uint64_t)i, seed);
+    }
+    return hits;
+}
+
+/**
+ * Reads a non-negative integer from the environment.
+ *
+ * @param name Name of the variable.
+ * @param fallback Value used when the variable is not set.
+ * @param min Smallest accepted value, 0 or 1.
+ * @return The parsed value.
+ * @throws Exits the program if the value is not an integer of at least min and print to stderr.
+ */
+long long env_count(const char *name, long long fallback, long long min) {
+    const char *value = getenv(name);
+    if (!value) {
+        return fallback;
+    }
+    char *end;
+    errno = 0;
+    long long parsed = strtoll(value, &end, 10);
+    if (end == value || *end != '\0' || errno == ERANGE || parsed < min) {
+        fprintf(stderr, "Error: %s must be a %s integer.\n", name, min > 0 ? "positive" : "non-negative");
+        exit(1);
+    }
+    return parsed;
+}
+
+/**
+ * Reads a 64 bit generator key from the environment. Any value is a valid
+ * Philox key, including 0.
+ *
+ * @param name Name of the variable.
+ * @param fallback Value used when the variable is not set.
+ * @return The parsed value.
+ * @throws Exits the program if the value is not an unsigned 64 bit integer and print to stderr.
+ */
+uint64_t env_seed(const char *name, uint64_t fallback) {
+    const char *value = getenv(name);
+    if (!value) {
+        return fallback;
+    }
+    char *end;
+    errno = 0;
+    unsigned long long parsed = strtoull(value, &end, 10);
+    // strtoull negates a leading minus sign instead of rejecting it
+    if (end == value || *end != '\0' || errno == ERANGE || strchr(value, '-')) {
+        fprintf(stderr, "Error: %s must be an unsigned 64 bit integer.\n", name);
+        exit(1);
+    }
+    return (uint64_t)parsed;
+}
+
+/**
+ * Adds this thread's share of the Leibniz series to pi. Must be called from
+ * inside a parallel region, the iterations are split with schedule(runtime).
+ *
+ * @param niter Number of terms to sum.
+ * @param pi Shared accumulator.
+ */
+static void leibniz_team(long long niter, double *pi) {
+    double local = 0;
+    #pragma omp for schedule(runtime) nowait
+    for (long long i = 0; i < niter; i++){
+        local = local + pow(-1, i) * (4 / (2 * ((double)i) + 1));
+    }
+    #pragma omp atomic
+    *pi += local;
+}
+
+/**
+ * Sums the Leibniz series with the current thread count and runtime schedule.
+ *
+ * @param niter Number of terms to sum.
+ * @param bind Thread binding policy, one of BIND_*.
+ * @return The estimate of pi.
+ */
+double leibniz(long long niter, int bind) {
+    double pi = 0;
+    // proc_bind only takes a constant, so every policy gets its own region
+    switch (bind) {
+    case BIND_CLOSE:
+        #pragma omp parallel proc_bind(close)
+        leibniz_team(niter, &pi);
+        break;
+    case BIND_SPREAD:
+        #pragma omp parallel proc_bind(spread)
+        leibniz_team(niter, &pi);
+        break;
+    default:
+        #pragma omp parallel
+        leibniz_team(niter, &pi);
+        break;
+    }
+    return pi;
+}
+
+/**
+ * Returns the OMP_SCHEDULE name of a schedule kind.
+ *
+ * @param kind Schedule kind.
+ * @return Its name.
+ */
+const char *sched_name(omp_sched_t kind) {
+    switch (kind & ~omp_sched_monotonic) {
+    case omp_sched_static: return "static";
+    case omp_sched_dynamic: return "dynamic";
+    case omp_sched_guided: return "guided";
+    default: return "auto";
+    }
+}
+
+/**
+ * Returns the OMP_PLACES value the program was started with. The runtime reads it
+ * once at startup, so a configuration is only valid under the places it was tuned with.
+ *
+ * @return The value of OMP_PLACES, or "(unset)".
+ */
+const char *places_name(void) {
+    const char *places = getenv("OMP_PLACES");
+    return places ? places : "(unset)";
+}
+
+/**
+ * Builds the path of the per machine file caching the fastest configuration.
+ *
+ * @param path Output buffer.
+ * @param size Size of the output buffer.
+ */
+void tune_cache_path(char *path, size_t size) {
+    char host[256] = "unknown";
+    gethostname(host, sizeof(host) - 1);
+    snprintf(path, size, "pi_tune_%s.cfg", host);
+}
+
+/**
+ * Loads the fastest configuration cached for this machine, if it was tuned
+ * under the current OMP_PLACES.
+ *
+ * @param config Output configuration.
+ * @return 1 if a configuration was cached, 0 otherwise.
+ */
+int load_tuned(config_t *config) {
+    char path[300], kind[16], bind[16], places[256];
+    tune_cache_path(path, sizeof(path));
+    FILE *f = fopen(path, "r");
+    if (!f) {
+        return 0;
+    }
+    int found = fscanf(f, "%d %15s %d %15s %255[^\n]", &config->threads, kind, &config->chunk, bind, places) == 5;
+    fclose(f);
+    if (!found || config->threads <= 0 || strcmp(places, places_name()) != 0) {
+        return 0;
+    }
+    config->kind = strcmp(kind, "dynamic") == 0 ? omp_sched_dynamic
+                 : strcmp(kind, "guided") == 0 ? omp_sched_guided : omp_sched_static;
+    config->bind = BIND_DEFAULT;
+    for (int b = 0; b < NUM_BINDS; b++) {
+        if (strcmp(bind, bind_names[b]) == 0) {
+            config->bind = b;
+        }
+    }
+    return 1;
+}
+
+/**
+ * Parses the comma separated thread counts in TUNE_THREADS. By default every
+ * multiple of 4 up to the number of processors is swept, like Task 1/job.sh did.
+ *
+ * @param threads Output array of thread counts.
+ * @return Number of thread counts.
+ * @throws Exits the program if the list is malformed and print to stderr.
+ */
+int tune_threads(int *threads) {
+    const char *list = getenv("TUNE_THREADS");
+    int count = 0;
+    if (!list) {
+        int procs = omp_get_num_procs();
+        if (procs < 4) {
+            threads[count++] = procs;
+        }
+        for (int t = 4; t <= procs && count < MAX_TUNE_THREADS; t += 4) {
+            threads[count++] = t;
+        }
+        return count;
+    }
+    char *end;
+    while (*list && count < MAX_TUNE_THREADS) {
+        long value = strtol(list, &end, 10);
+        if (end == list || value <= 0 || (*end != ',' && *end != '\0')) {
+            fprintf(stderr, "Error: Invalid thread count in TUNE_THREADS=\"%s\".\n", list);
+            exit(1);
+        }
+        threads[count++] = (int)value;
+        list = (*end == ',') ? end + 1 : end;
+    }
+    if (count == 0) {
+        fprintf(stderr, "Error: TUNE_THREADS must contain at least one thread count.\n");
+        exit(1);
+    }
+    return count;
+}
+
+/**
+ * Sweeps thread counts, schedule kinds, chunk sizes and binding policies of the
+ * Leibniz loop. Each configuration gets TUNE_WARMUP untimed runs and TUNE_TRIALS
+ * timed runs; the mean latency and its 95% confidence interval are written to
+ * TUNE_CSV in the CPUs,latency format of 4_4_512_rome.csv with extra columns.
+ * The fastest configuration is cached per machine together with OMP_PLACES, and
+ * used by later runs started with the same OMP_PLACES. The places themselves are
+ * fixed at startup, so sweeping them takes one tuning run per value.
+ *
+ * @param niter Number of terms summed by every run.
+ * @return Exit status code (0 for success, 1 for error).
+ */
+int tune(long long niter) {
+    static const omp_sched_t kinds[] = {omp_sched_static, omp_sched_dynamic, omp_sched_guided};
+    static const int chunks[] = {0, 16384, 262144};
+    int threads[MAX_TUNE_THREADS];
+    int nthreads = tune_threads(threads);
+    long long warmup = env_count("TUNE_WARMUP", 1, 0);
+    long long trials = env_count("TUNE_TRIALS", 5, 1);
+    if (trials > MAX_TUNE_TRIALS) {
+        trials = MAX_TUNE_TRIALS;
+    }
+    const char *csv_path = getenv("TUNE_CSV") ? getenv("TUNE_CSV") : "pi_tune.csv";
+    const char *places = places_name();
+
+    FILE *csv = fopen(csv_path, "w");
+    if (!csv) {
+        fprintf(stderr, "Error: Could not open %s for writing.\n", csv_path);
+        return 1;
+    }
+    fprintf(csv, "CPUs,latency,ci95,schedule,chunk,proc_bind,places\n");
+    printf("Tuning %lld iterations, OMP_PLACES=%s\n", niter, places);
+
+    config_t best = {0};
+    double best_latency = INFINITY;
+    double times[MAX_TUNE_TRIALS];
+    for (int t = 0; t < nthreads; t++) {
+        for (int k = 0; k < 3; k++) {
+            for (int c = 0; c < 3; c++) {
+                // A dynamic schedule without chunk hands out single iterations
+                if (kinds[k] == omp_sched_dynamic && chunks[c] == 0) {
+                    continue;
+                }
+                for (int b = 0; b < NUM_BINDS; b++) {
+                    config_t config = {threads[t], kinds[k], chunks[c], b};
+                    omp_set_num_threads(config.threads);
+                    omp_set_schedule(config.kind, config.chunk);
+                    for (long long w = 0; w < warmup; w++) {
+                        leibniz(niter, config.bind);
+                    }
+
+                    double mean = 0, var = 0;
+                    for (int r = 0; r < trials; r++) {
+                        double start = omp_get_wtime();
+                        leibniz(niter, config.bind);
+                        times[r] = omp_get_wtime() - start;
+                        mean += times[r];
+                    }
+                    mean /= trials;
+                    for (int r = 0; r < trials; r++) {
+                        var += (times[r] - mean) * (times[r] - mean);
+                    }
+                    double ci = 0;
+                    if (trials > 1) {
+                        double t_q = trials - 1 <= 30 ? t_quantiles[trials - 2] : 1.96;
+                        ci = t_q * sqrt(var / (trials - 1) / trials);
+                    }
+
+                    // Place lists such as {0,1},{2,3} contain commas, so the field is quoted
+                    fprintf(csv, "%d,%f,%f,%s,%d,%s,\"%s\"\n", config.threads, mean, ci,
+                            sched_name(config.kind), config.chunk, bind_names[config.bind], places);
+                    printf("CPUS: %d schedule: %s,%d proc_bind: %s latency: %f +- %f\n", config.threads,
+                           sched_name(config.kind), config.chunk, bind_names[config.bind], mean, ci);
+                    if (mean < best_latency) {
+                        best_latency = mean;
+                        best = config;
+                    }
+                }
+            }
+        }
+    }
+    fclose(csv);
+
+    char path[300];
+    tune_cache_path(path, sizeof(path));
+    FILE *f = fopen(path, "w");
+    if (f) {
+        fprintf(f, "%d %s %d %s %s\n", best.threads, sched_name(best.kind), best.chunk, bind_names[best.bind], places);
+        fclose(f);
+    } else {
+        fprintf(stderr, "Warning: Could not write %s.\n", path);
+    }
+    printf("Fastest: CPUS: %d schedule: %s,%d proc_bind: %s latency: %f, cached in %s\n", best.threads,
+           sched_name(best.kind), best.chunk, bind_names[best.bind], best_latency, path);
+    return 0;
+}
+
+/**
+ * Computes pi with the method selected by PI_METHOD: "leibniz" (default) sums
+ * the Leibniz series, "montecarlo" samples NSAMPLES points seeded with SEED.
+ * With PI_TUNE set, the Leibniz loop is autotuned instead (see tune).
+ *
+ * @param argc Number of command-line arguments.
+ * @param argv Array of command-line arguments.
+ * @return Exit status code (0 for success, 1 for error).
+ */
 int main(int argc, char *argv[]){
+    const char *method = getenv("PI_METHOD");
+    if (method && strcmp(method, "montecarlo") == 0) {
+        long long npairs = (env_count("NSAMPLES", 1000000000, 1) + 1) / 2;
+        long long nsamples = 2 * npairs;
+        uint64_t seed = env_seed("SEED", 42);
+
+        double start = omp_get_wtime();
+        long long hits = monte_carlo_hits(npairs, seed);
+        double end = omp_get_wtime();
+
+        // Binomial standard error of 4 * hits / nsamples
+        double p = (double)hits / nsamples;
+        double pi = 4 * p;
+        double error = 4 * sqrt(p * (1 - p) / nsamples);
+        printf("Pi estimate: %.20f, obtained in %f seconds, samples: %lld, samples/s: %e, std error: %e\n",
+               pi, end-start, nsamples, nsamples / (end-start), error);
+        return 0;
+    } else if (method && strcmp(method, "leibniz") != 0) {
+        fprintf(stderr, "Error: Unknown PI_METHOD \"%s\", expected leibniz or montecarlo.\n", method);
+        return 1;
+    }
+
     // initialize variables
-    int i;
     double pi = 0;
-    int niter = 1000000000;
+    long long niter = 1000000000;
+
+    if (getenv("PI_TUNE")) {
+        return tune(env_count("TUNE_NITER", 100000000, 1));
+    }
+
+    // Use the tuned configuration unless the thread count is chosen explicitly
+    config_t config;
+    int bind = BIND_DEFAULT;
+    if (!getenv("OMP_NUM_THREADS") && load_tuned(&config)) {
+        omp_set_num_threads(config.threads);
+        omp_set_schedule(config.kind, config.chunk);
+        bind = config.bind;
+    } else if (!getenv("OMP_SCHEDULE")) {
+        omp_set_schedule(omp_sched_static, 0);
+    }
 
     // Get timing
     double start, end;
     start = omp_get_wtime();
 
     // Calculate PI using Leibnitz sum
+    pi = leibniz(niter, bind);
 
-    /* Fork a team of threads */
-    #pragma omp parallel for reduction(+ : pi)
-    for (i = 0; i < niter; i++){
-        pi = pi + pow(-1, i) * (4 / (2 * ((double)i) + 1));
-    } 
-    /* Reduction operation is done.       
-        All threads join master thread       
-        and disband */
     // Stop timing
     end = omp_get_wtime();
 
-    // Print result   
+    // Print result
     printf("Pi estimate: %.20f, obtained in %f seconds\n", pi, end-start);
-}
\ No newline at end of file
+}
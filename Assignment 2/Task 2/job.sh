@@ -13,11 +13,11 @@ module load GCCcore/11.3.0
 echo "OpenMP parallelism" 
 echo
 export OMP_NUM_THREADS=32 
-for niter in 31250000 62500000 125000000 250000000 500000000 1000000000 2000000000
-do 
-export NITER=$niter
+# One launch computes the series once and reports every boundary of the sweep
+export NITER=31250000,62500000,125000000,250000000,500000000,1000000000,2000000000
+# Uncomment to store the partial sums so later sweeps resume from them
+#export PI_CACHE=pi_cache.txt
 echo "ITERATIONS: " $NITER
 echo "ITERATIONS: " $NITER >&2 
 ./pi 
-echo "DONE " 
-done
\ No newline at end of file
+echo "DONE "
\ No newline at end of file
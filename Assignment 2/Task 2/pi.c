@@ -1,30 +1,238 @@
+#include <errno.h>
 #include <omp.h>
 #include <math.h>
 #include <stdio.h>
 #include <stdlib.h>
-int main(int argc, char *argv[]){
-    // initialize variables
-    int i;
-    double pi = 0;
-    int niter = atoi(getenv("NITER"));
 
-    // Get timing
-    double start, end;
-    start = omp_get_wtime();
+#define MAX_SWEEP 64
+#define MAX_CACHE 1024
+
+/**
+ * A partial sum of the Leibniz series: the sum of its first niter terms. The
+ * first cached terms were loaded from PI_CACHE, the others were computed by
+ * this run in the given number of seconds.
+ */
+typedef struct {
+    long long niter;
+    double sum;
+    long long cached;
+    double seconds;
+} prefix_t;
 
-    // Calculate PI using Leibnitz sum
+/**
+ * Sums the terms [from, to) of the Leibniz series in parallel.
+ *
+ * @param from Index of the first term.
+ * @param to Index one past the last term.
+ * @return The partial sum of the block.
+ */
+double leibniz_block(long long from, long long to) {
+    long long i;
+    double pi = 0;
 
     /* Fork a team of threads */
     #pragma omp parallel for reduction(+ : pi)
-    for (i = 0; i < niter; i++){
+    for (i = from; i < to; i++){
         pi = pi + pow(-1, i) * (4 / (2 * ((double)i) + 1));
-    } 
-    /* Reduction operation is done.       
-        All threads join master thread       
+    }
+    /* Reduction operation is done.
+        All threads join master thread
         and disband */
-    // Stop timing
-    end = omp_get_wtime();
+    return pi;
+}
+
+/**
+ * Parses a comma separated list of iteration counts (e.g. "31250000,62500000").
+ *
+ * @param list String to parse.
+ * @param niters Output array, filled in ascending order.
+ * @return Number of counts parsed.
+ * @throws Exits the program if the list is empty or malformed and print to stderr.
+ */
+int parse_sweep(const char *list, long long *niters) {
+    int count = 0;
+    char *end;
+    while (*list) {
+        if (count == MAX_SWEEP) {
+            fprintf(stderr, "Error: At most %d iteration counts are supported.\n", MAX_SWEEP);
+            exit(1);
+        }
+        errno = 0;
+        long long value = strtoll(list, &end, 10);
+        if (end == list || errno == ERANGE || value <= 0 || (*end != ',' && *end != '\0')
+            || (*end == ',' && end[1] == '\0')) {
+            fprintf(stderr, "Error: Invalid iteration count in NITER=\"%s\".\n", list);
+            exit(1);
+        }
+        // Insertion sort, the list is tiny
+        int pos = count++;
+        while (pos > 0 && niters[pos - 1] > value) {
+            niters[pos] = niters[pos - 1];
+            pos--;
+        }
+        niters[pos] = value;
+        list = (*end == ',') ? end + 1 : end;
+    }
+    if (count == 0) {
+        fprintf(stderr, "Error: NITER must contain at least one iteration count.\n");
+        exit(1);
+    }
+    return count;
+}
+
+/**
+ * Adds a prefix to the cache, replacing any prefix of the same length. When the
+ * cache is full the shortest prefix makes room, as longer ones save more work.
+ *
+ * @param cache Array of cached prefixes.
+ * @param count Number of cached prefixes, updated in place.
+ * @param prefix Prefix to add.
+ */
+void add_prefix(prefix_t *cache, int *count, prefix_t prefix) {
+    int shortest = 0;
+    for (int c = 0; c < *count; c++) {
+        if (cache[c].niter == prefix.niter) {
+            cache[c] = prefix;
+            return;
+        }
+        if (cache[c].niter < cache[shortest].niter) {
+            shortest = c;
+        }
+    }
+    if (*count < MAX_CACHE) {
+        cache[(*count)++] = prefix;
+    } else if (cache[shortest].niter < prefix.niter) {
+        cache[shortest] = prefix;
+    }
+}
+
+/**
+ * Loads the partial sums stored in the cache file, one "niter sum" pair per line.
+ * Sums are stored as hexadecimal floats so they are restored bit for bit.
+ *
+ * @param path Path of the cache file, a missing file is an empty cache.
+ * @param cache Output array of cached prefixes.
+ * @return Number of prefixes loaded.
+ */
+int load_cache(const char *path, prefix_t *cache) {
+    FILE *f = fopen(path, "r");
+    if (!f) {
+        return 0;
+    }
+    int count = 0;
+    prefix_t prefix;
+    while (fscanf(f, "%lld %la", &prefix.niter, &prefix.sum) == 2) {
+        prefix.cached = prefix.niter;
+        prefix.seconds = 0;
+        add_prefix(cache, &count, prefix);
+    }
+    fclose(f);
+    return count;
+}
+
+/**
+ * Rewrites the cache file with the given prefixes, one line per prefix length.
+ * The file is written next to the old one and renamed over it, so an interrupted
+ * run never leaves a truncated cache behind.
+ *
+ * @param path Path of the cache file.
+ * @param cache Array of prefixes to store.
+ * @param count Number of prefixes.
+ */
+void store_cache(const char *path, const prefix_t *cache, int count) {
+    char tmp[4096];
+    snprintf(tmp, sizeof(tmp), "%s.tmp", path);
+    FILE *f = fopen(tmp, "w");
+    if (!f) {
+        fprintf(stderr, "Warning: Could not write cache file %s.\n", path);
+        return;
+    }
+    for (int c = 0; c < count; c++) {
+        fprintf(f, "%lld %a\n", cache[c].niter, cache[c].sum);
+    }
+    if (fclose(f) != 0 || rename(tmp, path) != 0) {
+        fprintf(stderr, "Warning: Could not write cache file %s.\n", path);
+        remove(tmp);
+    }
+}
+
+/**
+ * Finds the longest cached prefix that does not exceed niter.
+ *
+ * @param cache Array of cached prefixes.
+ * @param count Number of cached prefixes.
+ * @param niter Upper bound on the prefix length.
+ * @return The longest usable prefix, or the empty prefix if none is cached.
+ */
+prefix_t best_prefix(const prefix_t *cache, int count, long long niter) {
+    prefix_t best = {0, 0, 0, 0};
+    for (int c = 0; c < count; c++) {
+        if (cache[c].niter <= niter && cache[c].niter > best.niter) {
+            best = cache[c];
+        }
+    }
+    return best;
+}
+
+/**
+ * Computes the Leibniz estimate of pi for every iteration count in NITER.
+ * NITER may be a single count or a comma separated sweep; the series is then
+ * computed once up to the largest count and reported at every requested boundary.
+ * If PI_CACHE names a file, the partial sums at each boundary are stored there
+ * and later runs resume from the longest stored prefix. The file is rewritten at
+ * the end of the run with one line per boundary, so it does not grow with reruns.
+ *
+ * @param argc Number of command-line arguments.
+ * @param argv Array of command-line arguments.
+ * @return Exit status code (0 for success, 1 for error).
+ */
+int main(int argc, char *argv[]){
+    // initialize variables
+    const char *niter_env = getenv("NITER");
+    if (!niter_env) {
+        fprintf(stderr, "Error: NITER is not set.\n");
+        return 1;
+    }
+    long long niters[MAX_SWEEP];
+    int nsweep = parse_sweep(niter_env, niters);
+
+    const char *cache_path = getenv("PI_CACHE");
+    static prefix_t cache[MAX_CACHE];
+    int ncache = cache_path ? load_cache(cache_path, cache) : 0;
+
+    // Calculate PI using Leibnitz sum, one block per requested boundary
+    int updated = 0;
+    for (int s = 0; s < nsweep; s++) {
+        prefix_t result = best_prefix(cache, ncache, niters[s]);
+        if (result.niter < niters[s]) {
+            if (result.niter > 0 && result.cached == result.niter) {
+                printf("Resuming from cached prefix of %lld iterations\n", result.niter);
+            }
+            // Get timing
+            double start, end;
+            start = omp_get_wtime();
+            result.sum = result.sum + leibniz_block(result.niter, niters[s]);
+            // Stop timing
+            end = omp_get_wtime();
+
+            result.seconds = result.seconds + (end - start);
+            result.niter = niters[s];
+            add_prefix(cache, &ncache, result);
+            updated = 1;
+        }
 
-    // Print result   
-    printf("Pi estimate: %.20f, obtained in %f seconds, iterations: %d\n", pi, end-start, niter);
-}
\ No newline at end of file
+        // Print result, only sums computed from zero give the latency of the whole series
+        if (result.cached == result.niter) {
+            printf("Pi estimate: %.20f, cached, iterations: %lld\n", result.sum, result.niter);
+        } else if (result.cached > 0) {
+            printf("Pi estimate: %.20f, obtained in %f seconds for the last %lld iterations, iterations: %lld\n",
+                   result.sum, result.seconds, result.niter - result.cached, result.niter);
+        } else {
+            printf("Pi estimate: %.20f, obtained in %f seconds, iterations: %lld\n", result.sum, result.seconds, result.niter);
+        }
+    }
+    if (cache_path && updated) {
+        store_cache(cache_path, cache, ncache);
+    }
+    return 0;
+}
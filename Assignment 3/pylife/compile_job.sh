@@ -0,0 +1,7 @@
+#!/bin/bash 
+#SBATCH --partition=cbuild 
+module load 2022 
+module load GCCcore/11.3.0 
+module load Python/3.10.4-GCCcore-11.3.0 
+# Target the Zen 2 CPUs of the rome partition, not the build node
+gcc -O3 -march=znver2 -fopenmp -fPIC -shared $(python3-config --includes) -o _life$(python3-config --extension-suffix) lifemodule.c
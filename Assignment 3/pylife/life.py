@@ -0,0 +1,48 @@
+# Zero-copy Python interface to the native Game of Life simulator (build it with compile_job.sh)
+
+import os
+import sys
+import numpy as np
+import _life
+
+sys.path.append(os.path.join(os.path.dirname(os.path.abspath(__file__)), "..", "Game of Life Assignment 3"))
+from convert_rle import Pattern, parse_rle
+
+# The thread count applies to steps run from any Python thread
+set_num_threads = _life.set_num_threads
+get_max_threads = _life.get_max_threads
+
+
+class Life:
+    """A Game of Life simulation on a rows x cols grid, 3000 x 3000 like sim_*.c by default."""
+
+    def __init__(self, rows: int = 3000, cols: int = 3000, born: str = "B3", survive: str = "S23"):
+        self.grid = _life.Grid(rows, cols, born, survive)
+        # A view of the native grid, no copy: it always shows the current generation
+        self.cells = np.asarray(self.grid)
+
+    @classmethod
+    def from_pattern(cls, pattern: Pattern, row: int = 1500, col: int = 1500, rows: int = 3000, cols: int = 3000):
+        """Creates a simulation using the rules of a convert_rle Pattern and places it at (row, col)."""
+        life = cls(rows, cols, pattern.born, pattern.survive)
+        life.place(pattern, row, col)
+        return life
+
+    @classmethod
+    def from_rle(cls, filename: str, row: int = 1500, col: int = 1500, rows: int = 3000, cols: int = 3000):
+        """Same as from_pattern for an .rle file."""
+        return cls.from_pattern(parse_rle(filename), row, col, rows, cols)
+
+    def place(self, pattern: Pattern, row: int, col: int):
+        """Copies the cells of a convert_rle Pattern onto the grid with its top left corner at (row, col)."""
+        self.grid.place(np.asarray(pattern.cells, dtype=np.uint8), row, col)
+
+    def step(self, n: int = 1) -> np.ndarray:
+        """Runs up to n generations at native speed and returns the population after each one.
+        The trace is shorter than n if all cells died."""
+        trace = np.empty(n, dtype=np.int64)
+        done = self.grid.step(n, trace)
+        return trace[:done]
+
+    def population(self) -> int:
+        return int(np.count_nonzero(self.cells))
@@ -0,0 +1,457 @@
+#define PY_SSIZE_T_CLEAN
+#include <Python.h>
+#include <structmember.h>
+#include <omp.h>
+#include <stdint.h>
+#include <string.h>
+
+/**
+ * A Game of Life grid. cells is the current generation and is exported
+ * zero-copy through the buffer protocol, so it never moves; every generation
+ * is computed into scratch and copied back over the scanned box only.
+ */
+typedef struct {
+    PyObject_HEAD
+    Py_ssize_t rows;
+    Py_ssize_t cols;
+    uint8_t *cells;
+    uint8_t *scratch;
+    Py_ssize_t shape[2];
+    Py_ssize_t strides[2];
+    Py_ssize_t exports;  // number of buffer views of cells alive
+    int busy;            // set while step runs without the GIL
+    int born;     // bit n set: a dead cell with n live neighbors is born
+    int survive;  // bit n set: a live cell with n live neighbors survives
+} GridObject;
+
+// Threads used by step, set with set_num_threads; 0 uses the OpenMP default of
+// the stepping thread. Only accessed with the GIL held.
+static int step_threads = 0;
+
+// Define the 8 possible neighbor directions
+static const int directions[8][2] = {
+    {-1, -1}, {-1, 0}, {-1, 1},
+    { 0, -1},          { 0, 1},
+    { 1, -1}, { 1, 0}, { 1, 1}
+};
+
+/**
+ * Parses one half of a rule string such as "B3" or "S23" into a neighbor mask.
+ *
+ * @param rule Rule string, a letter followed by neighbor counts.
+ * @param mask Output mask.
+ * @return 0 on success, -1 with a Python exception set otherwise.
+ */
+static int parse_rule(const char *rule, int *mask) {
+    *mask = 0;
+    if (*rule && !(*rule >= '0' && *rule <= '9')) {
+        rule++;
+    }
+    for (; *rule; rule++) {
+        if (*rule < '0' || *rule > '8') {
+            PyErr_Format(PyExc_ValueError, "invalid neighbor count '%c' in rule", *rule);
+            return -1;
+        }
+        *mask |= 1 << (*rule - '0');
+    }
+    return 0;
+}
+
+/**
+ * Checks that __init__ ran, subclasses may skip it.
+ *
+ * @param self Grid.
+ * @return 0 if the grid has cells, -1 with a Python exception set otherwise.
+ */
+static int check_initialized(GridObject *self) {
+    if (!self->cells) {
+        PyErr_SetString(PyExc_RuntimeError, "grid is not initialized");
+        return -1;
+    }
+    return 0;
+}
+
+/**
+ * Checks that no step is running on the grid, cells and scratch must not be
+ * touched or freed while another thread steps without the GIL.
+ *
+ * @param self Grid.
+ * @return 0 if the grid is idle, -1 with a Python exception set otherwise.
+ */
+static int check_idle(GridObject *self) {
+    if (self->busy) {
+        PyErr_SetString(PyExc_RuntimeError, "grid is being stepped in another thread");
+        return -1;
+    }
+    return 0;
+}
+
+/**
+ * Checks that a buffer format is a native int64_t ("q", or "l" where long is 64 bits).
+ *
+ * @param format Struct module format string, NULL means unsigned bytes.
+ * @return 1 if the format matches int64_t, 0 otherwise.
+ */
+static int is_int64_format(const char *format) {
+    if (!format) {
+        return 0;
+    }
+    if (*format == '@' || *format == '='
+#if PY_LITTLE_ENDIAN
+        || *format == '<'
+#else
+        || *format == '>' || *format == '!'
+#endif
+        ) {
+        format++;
+    }
+    return (format[0] == 'q' || (format[0] == 'l' && sizeof(long) == sizeof(int64_t))) && format[1] == '\0';
+}
+
+static void Grid_dealloc(GridObject *self) {
+    PyMem_RawFree(self->cells);
+    PyMem_RawFree(self->scratch);
+    Py_TYPE(self)->tp_free((PyObject *)self);
+}
+
+static int Grid_init(GridObject *self, PyObject *args, PyObject *kwds) {
+    static char *kwlist[] = {"rows", "cols", "born", "survive", NULL};
+    Py_ssize_t rows, cols;
+    const char *born = "B3", *survive = "S23";
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "nn|ss", kwlist, &rows, &cols, &born, &survive)) {
+        return -1;
+    }
+    if (rows <= 0 || cols <= 0) {
+        PyErr_SetString(PyExc_ValueError, "rows and cols must be positive");
+        return -1;
+    }
+    // The buffer export and the scans index cells with rows * cols
+    if (rows > PY_SSIZE_T_MAX / cols) {
+        PyErr_SetString(PyExc_OverflowError, "rows * cols is too large");
+        return -1;
+    }
+    if (check_idle(self) < 0) {
+        return -1;
+    }
+    if (self->exports > 0) {
+        PyErr_SetString(PyExc_BufferError, "cannot reinitialize a grid while views of it exist");
+        return -1;
+    }
+    // Parse and allocate everything first, so a failure leaves the grid as it was
+    int born_mask, survive_mask;
+    if (parse_rule(born, &born_mask) < 0 || parse_rule(survive, &survive_mask) < 0) {
+        return -1;
+    }
+    // step only scans around live cells, so dead cells with no live neighbors must stay dead
+    if (born_mask & 1) {
+        PyErr_SetString(PyExc_ValueError, "rules where cells are born with 0 neighbors (B0) are not supported");
+        return -1;
+    }
+    uint8_t *cells = PyMem_RawCalloc(rows, cols);
+    uint8_t *scratch = PyMem_RawCalloc(rows, cols);
+    if (!cells || !scratch) {
+        PyMem_RawFree(cells);
+        PyMem_RawFree(scratch);
+        PyErr_NoMemory();
+        return -1;
+    }
+    PyMem_RawFree(self->cells);
+    PyMem_RawFree(self->scratch);
+    self->cells = cells;
+    self->scratch = scratch;
+    self->born = born_mask;
+    self->survive = survive_mask;
+    self->rows = self->shape[0] = rows;
+    self->cols = self->shape[1] = cols;
+    self->strides[0] = cols;
+    self->strides[1] = 1;
+    return 0;
+}
+
+/**
+ * Finds the bounding box of the live cells. The grid may have been written
+ * through its buffer since the last step, so this is redone on every call.
+ *
+ * @param self Grid.
+ * @param box Output, {minRow, maxRow, minCol, maxCol}; empty when minRow > maxRow.
+ * @param nthreads Number of OpenMP threads.
+ */
+static void bounding_box(GridObject *self, Py_ssize_t box[4], int nthreads) {
+    Py_ssize_t rows = self->rows, cols = self->cols;
+    Py_ssize_t minRow = rows, maxRow = -1, minCol = cols, maxCol = -1;
+    #pragma omp parallel for num_threads(nthreads) reduction(min : minRow, minCol) reduction(max : maxRow, maxCol)
+    for (Py_ssize_t i = 0; i < rows; i++) {
+        const uint8_t *row = self->cells + i * cols;
+        for (Py_ssize_t j = 0; j < cols; j++) {
+            if (row[j]) {
+                if (i < minRow) minRow = i;
+                if (i > maxRow) maxRow = i;
+                if (j < minCol) minCol = j;
+                if (j > maxCol) maxCol = j;
+            }
+        }
+    }
+    box[0] = minRow;
+    box[1] = maxRow;
+    box[2] = minCol;
+    box[3] = maxCol;
+}
+
+/**
+ * Advances the grid by up to n generations, the same scheme as sim_grower.c:
+ * only the bounding box of the live cells grown by one is scanned. Runs
+ * without the GIL.
+ *
+ * @param self Grid.
+ * @param n Number of generations.
+ * @param trace Output population after every generation, may be NULL.
+ * @param nthreads Number of OpenMP threads.
+ * @return Number of generations computed, fewer than n if all cells died.
+ */
+static Py_ssize_t run_generations(GridObject *self, Py_ssize_t n, int64_t *trace, int nthreads) {
+    Py_ssize_t rows = self->rows, cols = self->cols;
+    uint8_t *old_grid = self->cells, *new_grid = self->scratch;
+    int born = self->born, survive = self->survive;
+    Py_ssize_t box[4];
+    bounding_box(self, box, nthreads);
+
+    for (Py_ssize_t curr = 0; curr < n; curr++) {
+        if (box[0] > box[1]) {
+            return curr;
+        }
+        // Expand the bounding box for neighbor checking
+        Py_ssize_t scanMinRow = (box[0] > 0) ? (box[0] - 1) : 0;
+        Py_ssize_t scanMaxRow = (box[1] < rows - 1) ? (box[1] + 1) : (rows - 1);
+        Py_ssize_t scanMinCol = (box[2] > 0) ? (box[2] - 1) : 0;
+        Py_ssize_t scanMaxCol = (box[3] < cols - 1) ? (box[3] + 1) : (cols - 1);
+        Py_ssize_t width = scanMaxCol - scanMinCol + 1;
+
+        Py_ssize_t newMinRow = rows, newMaxRow = -1;
+        Py_ssize_t newMinCol = cols, newMaxCol = -1;
+        int64_t population = 0;
+
+        #pragma omp parallel for num_threads(nthreads) reduction(+ : population) reduction(min : newMinRow, newMinCol) \
+            reduction(max : newMaxRow, newMaxCol)
+        for (Py_ssize_t i = scanMinRow; i <= scanMaxRow; i++) {
+            for (Py_ssize_t j = scanMinCol; j <= scanMaxCol; j++) {
+                int live_neighbors = 0;
+
+                // Count live neighbors
+                for (int d = 0; d < 8; d++) {
+                    Py_ssize_t ni = i + directions[d][0];
+                    Py_ssize_t nj = j + directions[d][1];
+                    if (ni >= 0 && ni < rows && nj >= 0 && nj < cols) {
+                        live_neighbors += old_grid[ni * cols + nj];
+                    }
+                }
+
+                // Apply the rules
+                int mask = old_grid[i * cols + j] ? survive : born;
+                uint8_t cell = (mask >> live_neighbors) & 1;
+                new_grid[i * cols + j] = cell;
+                if (cell) {
+                    population++;
+                    if (i < newMinRow) newMinRow = i;
+                    if (i > newMaxRow) newMaxRow = i;
+                    if (j < newMinCol) newMinCol = j;
+                    if (j > newMaxCol) newMaxCol = j;
+                }
+            }
+        }
+
+        // Everything outside the scanned box is dead in both generations, so copying it back is enough
+        #pragma omp parallel for num_threads(nthreads)
+        for (Py_ssize_t i = scanMinRow; i <= scanMaxRow; i++) {
+            memcpy(old_grid + i * cols + scanMinCol, new_grid + i * cols + scanMinCol, width);
+        }
+
+        box[0] = newMinRow;
+        box[1] = newMaxRow;
+        box[2] = newMinCol;
+        box[3] = newMaxCol;
+        if (trace) {
+            trace[curr] = population;
+        }
+    }
+    return n;
+}
+
+static PyObject *Grid_step(GridObject *self, PyObject *args, PyObject *kwds) {
+    static char *kwlist[] = {"n", "trace", NULL};
+    Py_ssize_t n;
+    PyObject *trace_obj = Py_None;
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "n|O", kwlist, &n, &trace_obj)
+        || check_initialized(self) < 0 || check_idle(self) < 0) {
+        return NULL;
+    }
+    if (n < 0) {
+        PyErr_SetString(PyExc_ValueError, "n must not be negative");
+        return NULL;
+    }
+
+    Py_buffer trace = {0};
+    if (trace_obj != Py_None) {
+        if (PyObject_GetBuffer(trace_obj, &trace, PyBUF_WRITABLE | PyBUF_C_CONTIGUOUS | PyBUF_FORMAT) < 0) {
+            return NULL;
+        }
+        if (trace.itemsize != sizeof(int64_t) || !is_int64_format(trace.format) || trace.len / trace.itemsize < n) {
+            PyBuffer_Release(&trace);
+            PyErr_SetString(PyExc_ValueError, "trace must be a writable int64 buffer of at least n elements");
+            return NULL;
+        }
+    }
+
+    // Set and cleared with the GIL held, so other threads see it before touching the grid
+    Py_ssize_t done;
+    int nthreads = step_threads > 0 ? step_threads : omp_get_max_threads();
+    self->busy = 1;
+    Py_BEGIN_ALLOW_THREADS
+    done = run_generations(self, n, trace.buf, nthreads);
+    Py_END_ALLOW_THREADS
+    self->busy = 0;
+
+    if (trace.obj) {
+        PyBuffer_Release(&trace);
+    }
+    return PyLong_FromSsize_t(done);
+}
+
+static PyObject *Grid_place(GridObject *self, PyObject *args) {
+    PyObject *pattern_obj;
+    Py_ssize_t row, col;
+    if (!PyArg_ParseTuple(args, "Onn", &pattern_obj, &row, &col)
+        || check_initialized(self) < 0 || check_idle(self) < 0) {
+        return NULL;
+    }
+    Py_buffer pattern;
+    if (PyObject_GetBuffer(pattern_obj, &pattern, PyBUF_C_CONTIGUOUS | PyBUF_FORMAT) < 0) {
+        return NULL;
+    }
+    if (pattern.ndim != 2 || pattern.itemsize != 1) {
+        PyBuffer_Release(&pattern);
+        PyErr_SetString(PyExc_ValueError, "pattern must be a 2D uint8 buffer");
+        return NULL;
+    }
+    Py_ssize_t height = pattern.shape[0], width = pattern.shape[1];
+    // Ensure the pattern fits within the grid bounds
+    if (row < 0 || col < 0 || row > self->rows - height || col > self->cols - width) {
+        PyBuffer_Release(&pattern);
+        PyErr_SetString(PyExc_ValueError, "pattern does not fit within the grid bounds");
+        return NULL;
+    }
+    const uint8_t *src = pattern.buf;
+    for (Py_ssize_t i = 0; i < height; i++) {
+        for (Py_ssize_t j = 0; j < width; j++) {
+            self->cells[(row + i) * self->cols + col + j] = src[i * width + j] != 0;
+        }
+    }
+    PyBuffer_Release(&pattern);
+    Py_RETURN_NONE;
+}
+
+static int Grid_getbuffer(GridObject *self, Py_buffer *view, int flags) {
+    if (check_initialized(self) < 0) {
+        return -1;
+    }
+    view->obj = (PyObject *)self;
+    Py_INCREF(self);
+    view->buf = self->cells;
+    view->len = self->rows * self->cols;
+    view->readonly = 0;
+    view->itemsize = 1;
+    view->format = (flags & PyBUF_FORMAT) ? "B" : NULL;
+    view->ndim = 2;
+    view->shape = (flags & PyBUF_ND) == PyBUF_ND ? self->shape : NULL;
+    view->strides = (flags & PyBUF_STRIDES) == PyBUF_STRIDES ? self->strides : NULL;
+    view->suboffsets = NULL;
+    view->internal = NULL;
+    self->exports++;
+    return 0;
+}
+
+static void Grid_releasebuffer(GridObject *self, Py_buffer *view) {
+    self->exports--;
+}
+
+static PyBufferProcs Grid_as_buffer = {
+    .bf_getbuffer = (getbufferproc)Grid_getbuffer,
+    .bf_releasebuffer = (releasebufferproc)Grid_releasebuffer,
+};
+
+static PyMemberDef Grid_members[] = {
+    {"rows", T_PYSSIZET, offsetof(GridObject, rows), READONLY, "Number of rows."},
+    {"cols", T_PYSSIZET, offsetof(GridObject, cols), READONLY, "Number of columns."},
+    {NULL}
+};
+
+static PyMethodDef Grid_methods[] = {
+    {"step", (PyCFunction)(void (*)(void))Grid_step, METH_VARARGS | METH_KEYWORDS,
+     "step(n, trace=None)\n\nAdvances up to n generations without the GIL, writing the population after "
+     "every generation to trace (a writable int64 buffer). Returns the number of generations run."},
+    {"place", (PyCFunction)Grid_place, METH_VARARGS,
+     "place(pattern, row, col)\n\nCopies a 2D uint8 pattern onto the grid with its top left corner at (row, col)."},
+    {NULL}
+};
+
+static PyTypeObject GridType = {
+    PyVarObject_HEAD_INIT(NULL, 0)
+    .tp_name = "_life.Grid",
+    .tp_doc = "Grid(rows, cols, born='B3', survive='S23')\n\n"
+              "A Game of Life grid of uint8 cells, exposed zero-copy through the buffer protocol.",
+    .tp_basicsize = sizeof(GridObject),
+    .tp_flags = Py_TPFLAGS_DEFAULT,
+    .tp_new = PyType_GenericNew,
+    .tp_init = (initproc)Grid_init,
+    .tp_dealloc = (destructor)Grid_dealloc,
+    .tp_as_buffer = &Grid_as_buffer,
+    .tp_members = Grid_members,
+    .tp_methods = Grid_methods,
+};
+
+static PyObject *life_set_num_threads(PyObject *self, PyObject *arg) {
+    long n = PyLong_AsLong(arg);
+    if (n == -1 && PyErr_Occurred()) {
+        return NULL;
+    }
+    if (n <= 0) {
+        PyErr_SetString(PyExc_ValueError, "the number of threads must be positive");
+        return NULL;
+    }
+    step_threads = n < INT_MAX ? (int)n : INT_MAX;
+    Py_RETURN_NONE;
+}
+
+static PyObject *life_get_max_threads(PyObject *self, PyObject *unused) {
+    return PyLong_FromLong(step_threads > 0 ? step_threads : omp_get_max_threads());
+}
+
+static PyMethodDef life_methods[] = {
+    {"set_num_threads", life_set_num_threads, METH_O, "Sets the number of OpenMP threads used by step, from any Python thread."},
+    {"get_max_threads", life_get_max_threads, METH_NOARGS, "Returns the number of OpenMP threads step uses when called from this thread."},
+    {NULL}
+};
+
+static struct PyModuleDef life_module = {
+    PyModuleDef_HEAD_INIT,
+    .m_name = "_life",
+    .m_doc = "Native Game of Life simulator, see life.py.",
+    .m_size = -1,
+    .m_methods = life_methods,
+};
+
+PyMODINIT_FUNC PyInit__life(void) {
+    if (PyType_Ready(&GridType) < 0) {
+        return NULL;
+    }
+    PyObject *module = PyModule_Create(&life_module);
+    if (!module) {
+        return NULL;
+    }
+    Py_INCREF(&GridType);
+    if (PyModule_AddObject(module, "Grid", (PyObject *)&GridType) < 0) {
+        Py_DECREF(&GridType);
+        Py_DECREF(module);
+        return NULL;
+    }
+    return module;
+}
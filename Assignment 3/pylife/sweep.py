@@ -0,0 +1,17 @@
+# Thread sweep of the grower in one process, like sim_grower.sh but without a launch per run
+
+import sys
+import time
+import life
+
+pattern = sys.argv[1] if len(sys.argv) > 1 else "../Game of Life Assignment 3/grower.rle"
+generations = int(sys.argv[2]) if len(sys.argv) > 2 else 50000
+
+print("threads,seconds,final_population")
+for ncores in [1, 2, 4, 8, 16, 32, 64, 128]:
+    life.set_num_threads(ncores)
+    simulation = life.Life.from_rle(pattern)
+    start = time.time()
+    trace = simulation.step(generations)
+    end = time.time()
+    print(f"{ncores},{end - start:f},{trace[-1] if len(trace) else 0}", flush=True)
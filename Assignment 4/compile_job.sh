@@ -0,0 +1,7 @@
+#!/bin/bash 
+#SBATCH --partition=cbuild 
+module load 2022 
+module load GCCcore/11.3.0 
+# Target the Zen 2 CPUs of the rome partition, not the build node
+gcc -O3 -march=znver2 -fopenmp -fPIC -shared -o librotate.so rotate.c roll2d.c
+gcc -O3 -march=znver2 -fopenmp -o rotate_file rotate_file.c rotate.c
@@ -7,6 +7,7 @@ from pycuda.compiler import SourceModule
 import time 
 import csv
 import pandas as pd
+import rotate
 
 # Initialize input array with size=1024 since it's the highest and allows us to see the more differences
 # We do not time this since it is the imput creation
@@ -15,6 +16,8 @@ gpu_mem = []
 gpu_comp = []
 cpu_iter = []
 cpu_pythonic = []
+cpu_native = []
+cpu_native_inplace = []
 size = []
 for input_size in [1000, 5000, 25000, 125000, 625000, 3125000, 6250000, 12500000]:
     for _ in range(4):
@@ -108,15 +111,41 @@ for input_size in [1000, 5000, 25000, 125000, 625000, 3125000, 6250000, 12500000
         cpu_time = (end_cpu - start_cpu)*1000
         cpu_pythonic.append(cpu_time)
 
+        # CPU multithreaded implementation (native library, see rotate.c)
+
+        #################### Start CPU timing
+        start_cpu = time.time()
+
+        native_out = rotate.rotate_left(host_array, 1)
+
+        #################### End CPU timing
+        end_cpu = time.time()
+        cpu_time = (end_cpu - start_cpu)*1000
+        cpu_native.append(cpu_time)
+
+        # Same, in place (the copy is not timed)
+        inplace_out = host_array.copy()
+
+        #################### Start CPU timing
+        start_cpu = time.time()
+
+        rotate.rotate_left_inplace(inplace_out, 1)
+
+        #################### End CPU timing
+        end_cpu = time.time()
+        cpu_time = (end_cpu - start_cpu)*1000
+        cpu_native_inplace.append(cpu_time)
+
         # Task 2
         # Compare the different implementations
-        if (host_output == pythonic_out).all() and (pythonic_out == np.array(naive_out, dtype=np.int32)).all():
+        if (host_output == pythonic_out).all() and (pythonic_out == np.array(naive_out, dtype=np.int32)).all() \
+                and (native_out == pythonic_out).all() and (inplace_out == pythonic_out).all():
             print("Output OK")
         else:
             print("Output do not match, please investigate!")
 
     # Save results to output file
-    rows = zip(size, gpu_kernel, gpu_mem, gpu_comp, cpu_iter, cpu_pythonic)
+    rows = zip(size, gpu_kernel, gpu_mem, gpu_comp, cpu_iter, cpu_pythonic, cpu_native, cpu_native_inplace)
 
 data = { 
     'size': size,
@@ -124,7 +153,9 @@ data = {
     'mem_management': gpu_mem,
     'gpu_computation': gpu_comp,
     'cpu_iterative': cpu_iter,
-    'cpu_pythonic': cpu_pythonic
+    'cpu_pythonic': cpu_pythonic,
+    'cpu_native': cpu_native,
+    'cpu_native_inplace': cpu_native_inplace
 }
 
 df = pd.DataFrame(data)
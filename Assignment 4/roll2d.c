@@ -0,0 +1,149 @@
+#include <omp.h>
+#include <string.h>
+#include "roll2d.h"
+
+// Below this many bytes a single thread is faster than forking a team
+#define ROLL_PARALLEL_MIN_BYTES (1 << 17)
+
+/**
+ * Reduces a shift of any sign modulo n.
+ *
+ * @param shift Shift.
+ * @param n Length of the axis, not 0.
+ * @return The equivalent shift in [0, n).
+ */
+static size_t wrap_shift(long shift, size_t n) {
+    long r = shift % (long)n;
+    return r < 0 ? (size_t)(r + (long)n) : (size_t)r;
+}
+
+/**
+ * Rolls a grid of byte-copyable cells. Every output row is its rolled source
+ * row written as two contiguous segments; threads own blocks of consecutive
+ * rows, so each one streams through its own tile of both grids. Without a
+ * column shift the grid is a single 1D rotation of whole rows.
+ *
+ * @param grid Input grid.
+ * @param out Output grid.
+ * @param rows Number of rows.
+ * @param cols Number of columns.
+ * @param elem Size of a cell in bytes.
+ * @param shift_rows Shift along the rows.
+ * @param shift_cols Shift along the columns.
+ */
+static void roll2d_bytes(const char *grid, char *out, size_t rows, size_t cols, size_t elem,
+                         long shift_rows, long shift_cols) {
+    if (rows == 0 || cols == 0) {
+        return;
+    }
+    size_t sr = wrap_shift(shift_rows, rows);
+    size_t sc = wrap_shift(shift_cols, cols);
+    size_t row_bytes = cols * elem;
+    int parallel = rows * row_bytes >= ROLL_PARALLEL_MIN_BYTES;
+
+    if (sc == 0) {
+        // out rows [sr, rows) are grid rows [0, rows - sr) and the other way round
+        size_t total = rows * row_bytes, split = sr * row_bytes;
+        #pragma omp parallel if(parallel)
+        {
+            size_t t = omp_get_thread_num(), nt = omp_get_num_threads();
+            size_t lo = total * t / nt, hi = total * (t + 1) / nt;
+            if (lo < split) {
+                size_t end = hi < split ? hi : split;
+                memcpy(out + lo, grid + total - split + lo, end - lo);
+            }
+            if (hi > split) {
+                size_t begin = lo > split ? lo : split;
+                memcpy(out + begin, grid + begin - split, hi - begin);
+            }
+        }
+        return;
+    }
+
+    size_t head = sc * elem;
+    #pragma omp parallel for schedule(static) if(parallel)
+    for (size_t i = 0; i < rows; i++) {
+        const char *src = grid + ((i + rows - sr) % rows) * row_bytes;
+        char *dst = out + i * row_bytes;
+        memcpy(dst, src + row_bytes - head, head);
+        memcpy(dst + head, src, row_bytes - head);
+    }
+}
+
+void roll2d_i32(const int32_t *grid, int32_t *out, size_t rows, size_t cols, long shift_rows, long shift_cols) {
+    roll2d_bytes((const char *)grid, (char *)out, rows, cols, sizeof(int32_t), shift_rows, shift_cols);
+}
+
+void roll2d_u8(const uint8_t *grid, uint8_t *out, size_t rows, size_t cols, long shift_rows, long shift_cols) {
+    roll2d_bytes((const char *)grid, (char *)out, rows, cols, sizeof(uint8_t), shift_rows, shift_cols);
+}
+
+/**
+ * Reads len bits of a packed row starting at bit p, without wrapping.
+ *
+ * @param row Packed row.
+ * @param p First bit, p + len must not exceed the row length.
+ * @param len Number of bits, 1 to 64.
+ * @return The bits, first one in bit 0.
+ */
+static uint64_t bits_linear(const uint64_t *row, size_t p, size_t len) {
+    size_t w = p / 64, b = p % 64;
+    uint64_t v = row[w] >> b;
+    if (b + len > 64) {
+        v |= row[w + 1] << (64 - b);
+    }
+    return len == 64 ? v : v & ((1ull << len) - 1);
+}
+
+/**
+ * Reads len bits of a packed row of cols bits starting at bit p, wrapping around its end.
+ *
+ * @param row Packed row.
+ * @param cols Number of bits in the row.
+ * @param p First bit, less than cols.
+ * @param len Number of bits, 1 to 64 and at most cols.
+ * @return The bits, first one in bit 0.
+ */
+static uint64_t bits_circular(const uint64_t *row, size_t cols, size_t p, size_t len) {
+    size_t first = cols - p < len ? cols - p : len;
+    uint64_t v = bits_linear(row, p, first);
+    if (first < len) {
+        v |= bits_linear(row, 0, len - first) << first;
+    }
+    return v;
+}
+
+void roll2d_bits(const uint64_t *grid, uint64_t *out, size_t rows, size_t cols, long shift_rows, long shift_cols) {
+    if (rows == 0 || cols == 0) {
+        return;
+    }
+    size_t sr = wrap_shift(shift_rows, rows);
+    size_t sc = wrap_shift(shift_cols, cols);
+    size_t words = (cols + 63) / 64;
+
+    if (sc == 0) {
+        roll2d_bytes((const char *)grid, (char *)out, rows, words, sizeof(uint64_t), (long)sr, 0);
+        // Whole words were copied, clear the padding bits they brought along
+        if (cols % 64 != 0) {
+            uint64_t mask = (1ull << (cols % 64)) - 1;
+            #pragma omp parallel for schedule(static) if(rows * words * sizeof(uint64_t) >= ROLL_PARALLEL_MIN_BYTES)
+            for (size_t i = 0; i < rows; i++) {
+                out[i * words + words - 1] &= mask;
+            }
+        }
+        return;
+    }
+
+    // Output word w of a row holds bits [64w, 64w + 64), read from bit 64w - sc of the source row
+    #pragma omp parallel for schedule(static) if(rows * words * sizeof(uint64_t) >= ROLL_PARALLEL_MIN_BYTES)
+    for (size_t i = 0; i < rows; i++) {
+        const uint64_t *src = grid + ((i + rows - sr) % rows) * words;
+        uint64_t *dst = out + i * words;
+        size_t p = cols - sc;
+        for (size_t w = 0; w < words; w++) {
+            size_t len = cols - 64 * w < 64 ? cols - 64 * w : 64;
+            dst[w] = bits_circular(src, cols, p, len);
+            p = (p + 64) % cols;
+        }
+    }
+}
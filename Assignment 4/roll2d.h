@@ -0,0 +1,30 @@
+/* File: roll2d.h */
+
+#ifndef ROLL2D_H
+#define ROLL2D_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * Circularly shifts a rows x cols row-major grid like np.roll(grid, (shift_rows, shift_cols), (0, 1)):
+ * out[(i + shift_rows) mod rows][(j + shift_cols) mod cols] = grid[i][j].
+ * Shifts may be negative or larger than the grid.
+ *
+ * @param grid Input grid.
+ * @param out Output grid, must not overlap grid.
+ * @param rows Number of rows.
+ * @param cols Number of columns.
+ * @param shift_rows Shift along the rows (axis 0).
+ * @param shift_cols Shift along the columns (axis 1).
+ */
+void roll2d_i32(const int32_t *grid, int32_t *out, size_t rows, size_t cols, long shift_rows, long shift_cols);
+void roll2d_u8(const uint8_t *grid, uint8_t *out, size_t rows, size_t cols, long shift_rows, long shift_cols);
+
+/**
+ * Same for a bit-packed grid: cell (i, j) is bit j % 64 of word j / 64 of row i,
+ * every row takes (cols + 63) / 64 words and its padding bits are written as 0.
+ */
+void roll2d_bits(const uint64_t *grid, uint64_t *out, size_t rows, size_t cols, long shift_rows, long shift_cols);
+
+#endif
@@ -0,0 +1,97 @@
+# 2D circular shift (np.roll) of Life grids: native kernels against numpy and a naive loop
+
+import numpy as np
+import time
+import math
+import pandas as pd
+import rotate
+
+# Same sizes as evaluation.py, as close to square grids as possible
+shift_rows, shift_cols = 1, 1
+size = []
+cpu_iterative = []
+cpu_np_roll = []
+native_int = []
+native_uint8 = []
+native_bits = []
+for input_size in [1000, 5000, 25000, 125000, 625000, 3125000, 6250000, 12500000]:
+    cols = int(math.sqrt(input_size))
+    rows = input_size // cols
+    for _ in range(4):
+        size.append(input_size)
+        host_grid = np.random.randint(low=0, high=2, size=(rows, cols), dtype=np.int32)
+        host_uint8 = host_grid.astype(np.uint8)
+        host_bits = rotate.pack_grid(host_grid)
+
+        # CPU sequential implementation (naive)
+
+        #################### Start CPU timing
+        start_cpu = time.time()
+
+        naive_out = np.empty_like(host_grid)
+        for i in range(rows):
+            for j in range(cols):
+                naive_out[(i + shift_rows) % rows, (j + shift_cols) % cols] = host_grid[i, j]
+
+        #################### End CPU timing
+        end_cpu = time.time()
+        cpu_iterative.append((end_cpu - start_cpu)*1000)
+
+        # CPU sequential implementation (pythonic)
+
+        #################### Start CPU timing
+        start_cpu = time.time()
+
+        pythonic_out = np.roll(host_grid, (shift_rows, shift_cols), axis=(0, 1))
+
+        #################### End CPU timing
+        end_cpu = time.time()
+        cpu_np_roll.append((end_cpu - start_cpu)*1000)
+
+        # Native kernels (see roll2d.c), one per cell type
+
+        #################### Start CPU timing
+        start_cpu = time.time()
+
+        int_out = rotate.roll2d(host_grid, shift_rows, shift_cols)
+
+        #################### End CPU timing
+        end_cpu = time.time()
+        native_int.append((end_cpu - start_cpu)*1000)
+
+        #################### Start CPU timing
+        start_cpu = time.time()
+
+        uint8_out = rotate.roll2d(host_uint8, shift_rows, shift_cols)
+
+        #################### End CPU timing
+        end_cpu = time.time()
+        native_uint8.append((end_cpu - start_cpu)*1000)
+
+        #################### Start CPU timing
+        start_cpu = time.time()
+
+        bits_out = rotate.roll2d_bits(host_bits, cols, shift_rows, shift_cols)
+
+        #################### End CPU timing
+        end_cpu = time.time()
+        native_bits.append((end_cpu - start_cpu)*1000)
+
+        # Compare the different implementations
+        if (naive_out == pythonic_out).all() and (int_out == pythonic_out).all() \
+                and (uint8_out == pythonic_out).all() and (rotate.unpack_grid(bits_out, cols) == pythonic_out).all():
+            print("Output OK")
+        else:
+            print("Output do not match, please investigate!")
+
+data = {
+    'size': size,
+    'cpu_iterative': cpu_iterative,
+    'cpu_np_roll': cpu_np_roll,
+    'native_int': native_int,
+    'native_uint8': native_uint8,
+    'native_bits': native_bits
+}
+
+df = pd.DataFrame(data)
+df.groupby('size').mean().to_csv("roll_output.csv")
@@ -0,0 +1,396 @@
+#define _GNU_SOURCE
+#include <errno.h>
+#include <fcntl.h>
+#include <omp.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "rotate.h"
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+// Rotations whose shorter side fits in this many elements park it in a stack buffer
+#define ROT_BUFFER_ELEMS 4096
+// Below this many elements a single thread is faster than forking a team
+#define ROT_PARALLEL_MIN (1 << 15)
+// Outputs of at least this many bytes are written around the cache
+#define ROT_STREAM_MIN_BYTES (1 << 22)
+// Default amount of a memory mapped file touched at once
+#define ROT_FILE_WINDOW_BYTES (64 << 20)
+
+/**
+ * Bounds the working set of a rotation: every range is processed in steps of at
+ * most elems elements, the next step is prefetched and finished steps are released.
+ */
+typedef struct {
+    size_t elems;
+    void (*prefetch)(void *ctx, int32_t *p, size_t len);
+    void (*release)(void *ctx, int32_t *p, size_t len);
+    void *ctx;
+} window_t;
+
+/**
+ * Length of the next step over a range.
+ *
+ * @param win Window, NULL for none.
+ * @param remaining Number of elements left in the range.
+ * @return At most one window of elements, the whole rest without a window.
+ */
+static size_t step_len(const window_t *win, size_t remaining) {
+    return win && win->elems < remaining ? win->elems : remaining;
+}
+
+// Hooks of an optional window
+static void prefetch(const window_t *win, int32_t *p, size_t len) {
+    if (win && len > 0) {
+        win->prefetch(win->ctx, p, len);
+    }
+}
+
+static void release(const window_t *win, int32_t *p, size_t len) {
+    if (win && len > 0) {
+        win->release(win->ctx, p, len);
+    }
+}
+
+/**
+ * Splits [0, m) evenly over the threads of the current team.
+ *
+ * @param m Number of elements to split.
+ * @param lo Output, first element of this thread.
+ * @param hi Output, one past the last element of this thread.
+ */
+static void thread_range(size_t m, size_t *lo, size_t *hi) {
+    size_t t = omp_get_thread_num(), nt = omp_get_num_threads();
+    *lo = m * t / nt;
+    *hi = m * (t + 1) / nt;
+}
+
+/**
+ * Caps the team size so that every thread gets at least s of the m elements.
+ *
+ * @param m Number of elements to split.
+ * @param s Minimum chunk size.
+ * @return Number of threads to use.
+ */
+static int threads_for(size_t m, size_t s) {
+    size_t nt = omp_get_max_threads();
+    if (s > 0 && m / nt < s) {
+        nt = m / s;
+    }
+    return nt > 0 ? (int)nt : 1;
+}
+
+/**
+ * Swaps two disjoint ranges of len elements.
+ *
+ * @param x First range.
+ * @param y Second range.
+ * @param len Number of elements.
+ */
+static void swap_ranges(int32_t *x, int32_t *y, size_t len) {
+    #pragma omp parallel for simd schedule(static) if(len >= ROT_PARALLEL_MIN)
+    for (size_t i = 0; i < len; i++) {
+        int32_t tmp = x[i];
+        x[i] = y[i];
+        y[i] = tmp;
+    }
+}
+
+/**
+ * Moves a[s, s + m) down to a[0, m). Every thread first saves the s sources
+ * just past its chunk, which the next thread overwrites, so after one barrier
+ * all chunks can be moved independently.
+ *
+ * @param a Array.
+ * @param m Number of elements to move.
+ * @param s Distance, longer distances than ROT_BUFFER_ELEMS are moved by one thread.
+ */
+static void shift_down(int32_t *a, size_t m, size_t s) {
+    if (m < ROT_PARALLEL_MIN || s > ROT_BUFFER_ELEMS || m / s < 2) {
+        memmove(a, a + s, m * sizeof(int32_t));
+        return;
+    }
+    #pragma omp parallel num_threads(threads_for(m, s))
+    {
+        int32_t tail[ROT_BUFFER_ELEMS];
+        size_t lo, hi;
+        thread_range(m, &lo, &hi);
+        memcpy(tail, a + hi, s * sizeof(int32_t));
+        #pragma omp barrier
+        memmove(a + lo, a + lo + s, (hi - lo - s) * sizeof(int32_t));
+        memcpy(a + hi - s, tail, s * sizeof(int32_t));
+    }
+}
+
+/**
+ * Moves a[0, m) up to a[s, s + m), the mirror image of shift_down: every
+ * thread saves the first s sources of its chunk, which the previous thread
+ * overwrites.
+ *
+ * @param a Array.
+ * @param m Number of elements to move.
+ * @param s Distance, longer distances than ROT_BUFFER_ELEMS are moved by one thread.
+ */
+static void shift_up(int32_t *a, size_t m, size_t s) {
+    if (m < ROT_PARALLEL_MIN || s > ROT_BUFFER_ELEMS || m / s < 2) {
+        memmove(a + s, a, m * sizeof(int32_t));
+        return;
+    }
+    #pragma omp parallel num_threads(threads_for(m, s))
+    {
+        int32_t head[ROT_BUFFER_ELEMS];
+        size_t lo, hi;
+        thread_range(m, &lo, &hi);
+        memcpy(head, a + lo, s * sizeof(int32_t));
+        #pragma omp barrier
+        memmove(a + lo + 2 * s, a + lo + s, (hi - lo - s) * sizeof(int32_t));
+        memcpy(a + lo + s, head, s * sizeof(int32_t));
+    }
+}
+
+/**
+ * shift_down over a window: steps go up the array, so no step reads what an
+ * earlier one wrote.
+ */
+static void shift_down_windowed(int32_t *a, size_t m, size_t s, const window_t *win) {
+    for (size_t off = 0; off < m; ) {
+        size_t len = step_len(win, m - off);
+        prefetch(win, a + off + s + len, step_len(win, m - off - len));
+        shift_down(a + off, len, s);
+        release(win, a + off, len);
+        off += len;
+    }
+}
+
+/**
+ * shift_up over a window: steps go down the array, so no step reads what an
+ * earlier one wrote.
+ */
+static void shift_up_windowed(int32_t *a, size_t m, size_t s, const window_t *win) {
+    for (size_t end = m; end > 0; ) {
+        size_t len = step_len(win, end);
+        size_t next = step_len(win, end - len);
+        prefetch(win, a + end - len - next, next);
+        shift_up(a + end - len, len, s);
+        release(win, a + end - len + s, len);
+        end -= len;
+    }
+}
+
+/**
+ * swap_ranges over a window.
+ */
+static void swap_ranges_windowed(int32_t *x, int32_t *y, size_t len, const window_t *win) {
+    for (size_t off = 0; off < len; ) {
+        size_t step = step_len(win, len - off);
+        size_t next = step_len(win, len - off - step);
+        prefetch(win, x + off + step, next);
+        prefetch(win, y + off + step, next);
+        swap_ranges(x + off, y + off, step);
+        release(win, x + off, step);
+        release(win, y + off, step);
+        off += step;
+    }
+}
+
+/**
+ * Rotates arr left by k in place. Rotations whose shorter side fits in buf park
+ * it there and slide the rest over it, the others are reduced by Gries-Mills
+ * block swaps until they do. Every pass streams through memory in order.
+ *
+ * @param arr Array to rotate.
+ * @param n Number of elements.
+ * @param k Shift, less than n.
+ * @param buf Scratch buffer.
+ * @param buf_elems Capacity of buf.
+ * @param win Window bounding the working set, NULL to process whole ranges.
+ */
+static void rotate_engine(int32_t *arr, size_t n, size_t k, int32_t *buf, size_t buf_elems, const window_t *win) {
+    while (k != 0 && k != n) {
+        size_t right = n - k;
+        if (k <= buf_elems) {
+            // A B -> B A with a short A: park A, slide B down, put A back at the end
+            memcpy(buf, arr, k * sizeof(int32_t));
+            shift_down_windowed(arr, right, k, win);
+            memcpy(arr + right, buf, k * sizeof(int32_t));
+            release(win, arr + right, k);
+            return;
+        }
+        if (right <= buf_elems) {
+            // Same with a short B
+            memcpy(buf, arr + k, right * sizeof(int32_t));
+            shift_up_windowed(arr, k, right, win);
+            memcpy(arr, buf, right * sizeof(int32_t));
+            release(win, arr, right);
+            return;
+        }
+        // Gries-Mills block swap: move the shorter block to its final place and shrink the problem
+        if (k <= right) {
+            // A B1 B2 with |B2| = |A| -> B2 B1 A, then rotate B2 B1 left by |A|
+            swap_ranges_windowed(arr, arr + right, k, win);
+            n = right;
+        } else {
+            // A1 A2 B with |A1| = |B| -> B A2 A1, then rotate A2 A1 left by |A2|
+            swap_ranges_windowed(arr, arr + k, right, win);
+            arr += right;
+            n = k;
+            k -= right;
+        }
+    }
+}
+
+void rotate_left_inplace(int32_t *arr, size_t n, size_t k) {
+    if (n == 0) {
+        return;
+    }
+    int32_t buf[ROT_BUFFER_ELEMS];
+    rotate_engine(arr, n, k % n, buf, ROT_BUFFER_ELEMS, NULL);
+}
+
+/**
+ * A memory mapped file being rotated.
+ */
+typedef struct {
+    int fd;
+    char *base;
+    size_t page;
+} mapped_file_t;
+
+/**
+ * Widens [p, p + len) to whole pages of the mapping, as madvise requires.
+ *
+ * @param file Mapped file containing the range.
+ * @param p First element of the range.
+ * @param len Number of elements.
+ * @param start Output, first byte of the first page.
+ * @param bytes Output, length of the pages.
+ */
+static void page_align(const mapped_file_t *file, int32_t *p, size_t len, char **start, size_t *bytes) {
+    size_t from = ((char *)p - file->base) / file->page * file->page;
+    size_t to = (char *)(p + len) - file->base;
+    *start = file->base + from;
+    *bytes = to - from;
+}
+
+// Window hooks of a mapped file
+static void file_prefetch(void *ctx, int32_t *p, size_t len) {
+    char *start;
+    size_t bytes;
+    page_align(ctx, p, len, &start, &bytes);
+    madvise(start, bytes, MADV_WILLNEED);
+}
+
+static void file_release(void *ctx, int32_t *p, size_t len) {
+    mapped_file_t *file = ctx;
+    char *start;
+    size_t bytes;
+    page_align(file, p, len, &start, &bytes);
+    // Start writing the step back and drop it from our working set, the data stays in the page cache
+    sync_file_range(file->fd, start - file->base, bytes, SYNC_FILE_RANGE_WRITE);
+    madvise(start, bytes, MADV_DONTNEED);
+}
+
+int rotate_left_file(const char *path, size_t k, size_t window_bytes) {
+    int fd = open(path, O_RDWR);
+    if (fd < 0) {
+        return -1;
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0) {
+        close(fd);
+        return -1;
+    }
+    if (st.st_size % sizeof(int32_t) != 0) {
+        close(fd);
+        errno = EINVAL;
+        return -1;
+    }
+    size_t n = st.st_size / sizeof(int32_t);
+    if (n == 0 || k % n == 0) {
+        close(fd);
+        return 0;
+    }
+
+    mapped_file_t file = {fd, NULL, (size_t)sysconf(_SC_PAGESIZE)};
+    file.base = mmap(NULL, st.st_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (file.base == MAP_FAILED) {
+        close(fd);
+        return -1;
+    }
+
+    if (window_bytes == 0) {
+        window_bytes = ROT_FILE_WINDOW_BYTES;
+    }
+    window_t win = {window_bytes / sizeof(int32_t), file_prefetch, file_release, &file};
+    if (win.elems == 0) {
+        win.elems = 1;
+    }
+    // Short sides up to one window are parked in memory, a bounded working set either way
+    size_t buf_elems = win.elems < n ? win.elems : n;
+    int32_t *buf = malloc(buf_elems * sizeof(int32_t));
+    int status = -1;
+    if (buf) {
+        rotate_engine((int32_t *)file.base, n, k % n, buf, buf_elems, &win);
+        status = msync(file.base, st.st_size, MS_SYNC);
+        free(buf);
+    }
+    munmap(file.base, st.st_size);
+    close(fd);
+    return status;
+}
+
+/**
+ * Copies len elements, with non-temporal stores if requested and supported.
+ *
+ * @param dst Destination.
+ * @param src Source, must not overlap dst.
+ * @param len Number of elements.
+ * @param stream Whether to bypass the cache.
+ */
+static void copy_block(int32_t *dst, const int32_t *src, size_t len, int stream) {
+#ifdef __SSE2__
+    if (stream) {
+        size_t i = 0;
+        // Scalar stores until dst is 16 byte aligned
+        for (; i < len && ((uintptr_t)(dst + i) & 15); i++) {
+            dst[i] = src[i];
+        }
+        for (; i + 4 <= len; i += 4) {
+            _mm_stream_si128((__m128i *)(dst + i), _mm_loadu_si128((const __m128i *)(src + i)));
+        }
+        for (; i < len; i++) {
+            dst[i] = src[i];
+        }
+        _mm_sfence();
+        return;
+    }
+#endif
+    memcpy(dst, src, len * sizeof(int32_t));
+}
+
+void rotate_left_copy(const int32_t *arr, int32_t *out, size_t n, size_t k) {
+    if (n == 0) {
+        return;
+    }
+    k %= n;
+    int stream = n * sizeof(int32_t) >= ROT_STREAM_MIN_BYTES;
+    // out[i] = arr[i + k] up to wrap, out[i] = arr[i - wrap] after it
+    size_t wrap = n - k;
+    #pragma omp parallel if(n >= ROT_PARALLEL_MIN)
+    {
+        size_t lo, hi;
+        thread_range(n, &lo, &hi);
+        if (lo < wrap) {
+            size_t end = hi < wrap ? hi : wrap;
+            copy_block(out + lo, arr + lo + k, end - lo, stream);
+        }
+        if (hi > wrap) {
+            size_t begin = lo > wrap ? lo : wrap;
+            copy_block(out + begin, arr + begin - wrap, hi - begin, stream);
+        }
+    }
+}
@@ -0,0 +1,41 @@
+/* File: rotate.h */
+
+#ifndef ROTATE_H
+#define ROTATE_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * Rotates arr left by k positions in place: arr[i] ends up at arr[(i - k) mod n].
+ * Uses O(1) extra memory and all OpenMP threads for large arrays.
+ *
+ * @param arr Array to rotate.
+ * @param n Number of elements.
+ * @param k Shift, any value (taken modulo n).
+ */
+void rotate_left_inplace(int32_t *arr, size_t n, size_t k);
+
+/**
+ * Writes arr rotated left by k positions to out: out[i] = arr[(i + k) mod n].
+ * Large outputs are written with non-temporal stores so they bypass the cache.
+ *
+ * @param arr Input array.
+ * @param out Output array, must not overlap arr.
+ * @param n Number of elements.
+ * @param k Shift, any value (taken modulo n).
+ */
+void rotate_left_copy(const int32_t *arr, int32_t *out, size_t n, size_t k);
+
+/**
+ * Rotates a file of int32 values left by k positions in place through a
+ * memory mapping, touching at most a few windows of the file at a time.
+ *
+ * @param path File to rotate, its size must be a multiple of 4 bytes.
+ * @param k Shift in elements, any value (taken modulo the number of elements).
+ * @param window_bytes Size of a window, 0 for the default of 64 MiB.
+ * @return 0 on success, -1 on error with errno set.
+ */
+int rotate_left_file(const char *path, size_t k, size_t window_bytes);
+
+#endif
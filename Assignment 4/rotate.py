@@ -0,0 +1,89 @@
+# Python bindings for the native rotation library (build it with compile_job.sh)
+
+import ctypes
+import os
+import numpy as np
+
+_lib = ctypes.CDLL(os.path.join(os.path.dirname(os.path.abspath(__file__)), "librotate.so"), use_errno=True)
+_int_array = np.ctypeslib.ndpointer(dtype=np.int32, flags="C_CONTIGUOUS")
+# Arrays the library writes to, so read-only arrays are rejected instead of modified
+_int_out_array = np.ctypeslib.ndpointer(dtype=np.int32, flags="C_CONTIGUOUS,WRITEABLE")
+
+_lib.rotate_left_inplace.argtypes = [_int_out_array, ctypes.c_size_t, ctypes.c_size_t]
+_lib.rotate_left_inplace.restype = None
+_lib.rotate_left_copy.argtypes = [_int_array, _int_out_array, ctypes.c_size_t, ctypes.c_size_t]
+_lib.rotate_left_copy.restype = None
+
+
+def rotate_left(arr: np.ndarray, k: int = 1, out: np.ndarray = None) -> np.ndarray:
+    """Returns arr rotated left by k, like np.concatenate((arr[k:], arr[:k]))."""
+    if out is None:
+        out = np.empty_like(arr)
+    elif out.shape != arr.shape or np.shares_memory(out, arr):
+        raise ValueError("out must have the shape of arr and must not overlap it")
+    _lib.rotate_left_copy(arr, out, arr.size, k % max(arr.size, 1))
+    return out
+
+
+def rotate_left_inplace(arr: np.ndarray, k: int = 1) -> np.ndarray:
+    """Rotates arr left by k in place with O(1) extra memory and returns it."""
+    _lib.rotate_left_inplace(arr, arr.size, k % max(arr.size, 1))
+    return arr
+
+
+_lib.rotate_left_file.argtypes = [ctypes.c_char_p, ctypes.c_size_t, ctypes.c_size_t]
+_lib.rotate_left_file.restype = ctypes.c_int
+
+
+def rotate_left_file(path: str, k: int = 1, window_bytes: int = 0):
+    """Rotates a file of int32 values left by k in place, without loading it into memory."""
+    n = os.path.getsize(path) // 4
+    if _lib.rotate_left_file(os.fsencode(path), k % max(n, 1), window_bytes) != 0:
+        err = ctypes.get_errno()
+        raise OSError(err, os.strerror(err), path)
+
+
+_roll2d = {}
+for _dtype, _fn in [(np.int32, _lib.roll2d_i32), (np.uint8, _lib.roll2d_u8), (np.uint64, _lib.roll2d_bits)]:
+    _grid = np.ctypeslib.ndpointer(dtype=_dtype, ndim=2, flags="C_CONTIGUOUS")
+    _out_grid = np.ctypeslib.ndpointer(dtype=_dtype, ndim=2, flags="C_CONTIGUOUS,WRITEABLE")
+    _fn.argtypes = [_grid, _out_grid, ctypes.c_size_t, ctypes.c_size_t, ctypes.c_long, ctypes.c_long]
+    _fn.restype = None
+    _roll2d[np.dtype(_dtype)] = _fn
+
+
+def roll2d(grid: np.ndarray, shift_rows: int, shift_cols: int, out: np.ndarray = None) -> np.ndarray:
+    """Same as np.roll(grid, (shift_rows, shift_cols), axis=(0, 1)) for int32 and uint8 grids."""
+    if grid.dtype not in (np.int32, np.uint8):
+        raise TypeError(f"roll2d supports int32 and uint8 grids, not {grid.dtype}")
+    if out is None:
+        out = np.empty_like(grid)
+    elif out.shape != grid.shape or np.shares_memory(out, grid):
+        raise ValueError("out must have the shape of grid and must not overlap it")
+    _roll2d[grid.dtype](grid, out, grid.shape[0], grid.shape[1], shift_rows, shift_cols)
+    return out
+
+
+def pack_grid(grid: np.ndarray) -> np.ndarray:
+    """Packs a 2D grid of 0/1 cells into rows of uint64 words, cell j in bit j % 64 of word j // 64."""
+    rows, cols = grid.shape
+    padded = np.zeros((rows, (cols + 63) // 64 * 64), dtype=np.uint8)
+    padded[:, :cols] = grid != 0
+    return np.packbits(padded, axis=1, bitorder="little").view("<u8")
+
+
+def unpack_grid(packed: np.ndarray, cols: int) -> np.ndarray:
+    """Inverse of pack_grid, returns a uint8 grid."""
+    return np.unpackbits(packed.view(np.uint8), axis=1, bitorder="little")[:, :cols]
+
+
+def roll2d_bits(packed: np.ndarray, cols: int, shift_rows: int, shift_cols: int, out: np.ndarray = None) -> np.ndarray:
+    """roll2d for a grid of cols columns packed with pack_grid."""
+    if packed.ndim != 2 or (cols + 63) // 64 != packed.shape[1]:
+        raise ValueError(f"a packed grid of {cols} columns must have {(cols + 63) // 64} words per row")
+    if out is None:
+        out = np.empty_like(packed)
+    elif out.shape != packed.shape or np.shares_memory(out, packed):
+        raise ValueError("out must have the shape of packed and must not overlap it")
+    _roll2d[np.dtype(np.uint64)](packed, out, packed.shape[0], cols, shift_rows, shift_cols)
+    return out
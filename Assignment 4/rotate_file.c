@@ -0,0 +1,74 @@
+#include <errno.h>
+#include <omp.h>
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <sys/stat.h>
+#include "rotate.h"
+
+/**
+ * Parses a whole command-line argument as a signed integer.
+ *
+ * @param arg Argument to parse.
+ * @param name Name of the argument, used in the error message.
+ * @return The parsed value.
+ * @throws Exits the program if the argument is not an integer and print to stderr.
+ */
+long long parse_arg(const char *arg, const char *name) {
+    char *end;
+    errno = 0;
+    long long value = strtoll(arg, &end, 10);
+    if (end == arg || *end != '\0' || errno == ERANGE) {
+        fprintf(stderr, "Error: Invalid %s \"%s\".\n", name, arg);
+        exit(1);
+    }
+    return value;
+}
+
+/**
+ * Rotates a file of int32 values (e.g. written with numpy's tofile) left in place
+ * and reports the throughput. Works on files larger than memory.
+ *
+ * @param argc Number of command-line arguments.
+ * @param argv Array of command-line arguments: file, shift (negative to rotate right)
+ *             and optional window in MiB.
+ * @return Exit status code (0 for success, 1 for error).
+ */
+int main(int argc, char *argv[]) {
+    if (argc < 3) {
+        fprintf(stderr, "Usage: %s <file> <shift> [window MiB]\n", argv[0]);
+        return 1;
+    }
+    const char *path = argv[1];
+    long long shift = parse_arg(argv[2], "shift");
+    long long window_mib = argc > 3 ? parse_arg(argv[3], "window") : 0;
+    if (window_mib < 0 || (unsigned long long)window_mib > SIZE_MAX >> 20) {
+        fprintf(stderr, "Error: Invalid window \"%s\".\n", argv[3]);
+        return 1;
+    }
+    size_t window = (size_t)window_mib << 20;
+
+    struct stat st;
+    if (stat(path, &st) != 0) {
+        perror(path);
+        return 1;
+    }
+
+    // A right rotation by |shift| is a left rotation by n - (|shift| mod n)
+    size_t n = st.st_size / sizeof(int32_t);
+    size_t k = shift >= 0 ? (size_t)shift : (size_t)(-(shift + 1)) + 1;
+    if (shift < 0 && n > 0) {
+        k = (n - k % n) % n;
+    }
+
+    double start = omp_get_wtime();
+    if (rotate_left_file(path, k, window) != 0) {
+        perror(path);
+        return 1;
+    }
+    double end = omp_get_wtime();
+
+    double gb = st.st_size / 1e9;
+    printf("Rotated %f GB left by %zu elements in %f seconds, %f GB/s\n", gb, k, end - start, gb / (end - start));
+    return 0;
+}